@@ -0,0 +1,27 @@
+#version 330 core
+layout (location = 0) in vec3 pos;
+
+uniform int tiles_per_row;
+uniform float constant_range;
+
+out vec2 tile_coord;
+flat out vec2 complex_constant;
+
+// One instance per thumbnail: the full-screen quad is shrunk onto the tile
+// picked by gl_InstanceID and the tile's complex constant is derived from the
+// same grid, so thousands of Julia sets are drawn in a single draw call.
+void main()
+{
+    int col = gl_InstanceID % tiles_per_row;
+    int row = gl_InstanceID / tiles_per_row;
+    float tile_size = 2.0 / float(tiles_per_row);
+
+    tile_coord = pos.xy * 0.5 + 0.5;
+
+    // Rows are counted from the top of the window, matching the cursor
+    // coordinates used to pick a constant in play_around.cpp
+    vec2 tile_origin = vec2(-1.0 + col * tile_size, 1.0 - (row + 1) * tile_size);
+    gl_Position = vec4(tile_origin + tile_coord * tile_size, pos.z, 1.0);
+
+    complex_constant = ((vec2(col, row) + 0.5) / float(tiles_per_row) - 0.5) * constant_range;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Mirrors the std140 FrameParams uniform block declared in shader.frag
+struct FrameParams {
+  glm::vec2 screen_dimension;
+  glm::vec2 center;
+  glm::vec2 complex_constant;
+  float zoom;
+  int symmetry;
+};
+
+static_assert(sizeof(FrameParams) == 32,
+              "FrameParams must match the std140 layout of the uniform block");
@@ -1,5 +1,7 @@
+#include "frame_params.h"
 #include "shader.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
 
@@ -18,6 +20,10 @@ float default_center_y{0.5f};
 float complex_constant_x{0.15f};
 float complex_constant_y{-0.06f};
 
+bool show_atlas{false};
+int atlas_tiles_per_row{64};
+float atlas_constant_range{3.0f};
+
 float vertices[] = {
     -1.0f, -1.0f, -0.0f, // 1
     1.0f,  1.0f,  -0.0f, // 2
@@ -38,8 +44,19 @@ void mousebuttonCallback(GLFWwindow *window, int button, int action, int mods) {
   if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE) {
     double xpos, ypos;
     glfwGetCursorPos(window, &xpos, &ypos);
-    complex_constant_x = ((xpos / screen_width) - 0.5) * 3.0;
-    complex_constant_y = ((ypos / screen_height) - 0.5) * 3.0;
+
+    // Snap the constant to the centre of the clicked thumbnail and open it
+    // full size
+    if (show_atlas) {
+      int col = static_cast<int>(xpos / screen_width * atlas_tiles_per_row);
+      int row = static_cast<int>(ypos / screen_height * atlas_tiles_per_row);
+      xpos = (col + 0.5) / atlas_tiles_per_row * screen_width;
+      ypos = (row + 0.5) / atlas_tiles_per_row * screen_height;
+      show_atlas = false;
+    }
+
+    complex_constant_x = ((xpos / screen_width) - 0.5) * atlas_constant_range;
+    complex_constant_y = ((ypos / screen_height) - 0.5) * atlas_constant_range;
     std::cout << "Julia Set Complex Constant set to (" << complex_constant_x
               << ") + (" << complex_constant_y << "i)\n";
   }
@@ -66,6 +83,18 @@ void keyboardCallback(GLFWwindow *window, int key, int scancode, int action,
       symmetry = 3;
       return;
 
+    case GLFW_KEY_A:
+      show_atlas = !show_atlas;
+      return;
+
+    case GLFW_KEY_EQUAL:
+      atlas_tiles_per_row = std::min(atlas_tiles_per_row * 2, 256);
+      return;
+
+    case GLFW_KEY_MINUS:
+      atlas_tiles_per_row = std::max(atlas_tiles_per_row / 2, 4);
+      return;
+
     case GLFW_KEY_R:
       default_center_x = 0.5f;
       default_center_y = 0.5f;
@@ -99,6 +128,9 @@ int main() {
                "for the complex constant of the Julia Set\n";
   std::cout << "\t[2]\t\t:\tTwo-way symmetric fractal\n";
   std::cout << "\t[3]\t\t:\tThree-way symmetric fractal\n";
+  std::cout << "\t[a]\t\t:\tToggle the Julia atlas, click a thumbnail to "
+               "open it\n";
+  std::cout << "\t[+]/[-]\t\t:\tMore/fewer thumbnails in the Julia atlas\n";
 
   glfwInit();
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -146,18 +178,29 @@ int main() {
       std::filesystem::current_path().parent_path() / "shader.vert",
       std::filesystem::current_path().parent_path() / "shader.frag");
 
+  Shader atlas_shader(
+      std::filesystem::current_path().parent_path() / "atlas.vert",
+      std::filesystem::current_path().parent_path() / "atlas.frag");
+
   glEnable(GL_DEPTH_TEST);
   our_shader.use_shader();
-
-  GLint screenDimensions =
-      glGetUniformLocation(our_shader.program_ID, "screen_dimension");
-  GLint fractalCenter = glGetUniformLocation(our_shader.program_ID, "center");
-  GLint fractalZoom = glGetUniformLocation(our_shader.program_ID, "zoom");
-
-  GLint fractalConstant =
-      glGetUniformLocation(our_shader.program_ID, "complex_constant");
-  GLint fractalSymmetry =
-      glGetUniformLocation(our_shader.program_ID, "symmetry");
+  our_shader.bind_uniform_block("FrameParams", 0);
+
+  unsigned int UBO;
+  glGenBuffers(1, &UBO);
+  glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameParams), nullptr,
+               GL_DYNAMIC_DRAW);
+  glBindBufferBase(GL_UNIFORM_BUFFER, 0, UBO);
+
+  GLint atlasCenter = glGetUniformLocation(atlas_shader.program_ID, "center");
+  GLint atlasZoom = glGetUniformLocation(atlas_shader.program_ID, "zoom");
+  GLint atlasSymmetry =
+      glGetUniformLocation(atlas_shader.program_ID, "symmetry");
+  GLint atlasTilesPerRow =
+      glGetUniformLocation(atlas_shader.program_ID, "tiles_per_row");
+  GLint atlasConstantRange =
+      glGetUniformLocation(atlas_shader.program_ID, "constant_range");
 
   glfwSetKeyCallback(window, keyboardCallback);
   glfwSetScrollCallback(window, scrollCallback);
@@ -168,14 +211,29 @@ int main() {
     glClearColor(0.2f, 0.0f, 0.2f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glUniform2f(screenDimensions, screen_width, screen_height);
-    glUniform2f(fractalCenter, default_center_x, default_center_y);
-    glUniform1f(fractalZoom, default_zoom);
-
-    glUniform2f(fractalConstant, complex_constant_x, complex_constant_y);
-    glUniform1i(fractalSymmetry, symmetry);
-
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    if (show_atlas) {
+      // Every thumbnail is one instance of the quad, so the whole atlas costs
+      // a single draw call instead of one frame per constant
+      atlas_shader.use_shader();
+      glUniform2f(atlasCenter, default_center_x, default_center_y);
+      glUniform1f(atlasZoom, default_zoom);
+      glUniform1i(atlasSymmetry, symmetry);
+      glUniform1i(atlasTilesPerRow, atlas_tiles_per_row);
+      glUniform1f(atlasConstantRange, atlas_constant_range);
+
+      glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0,
+                              atlas_tiles_per_row * atlas_tiles_per_row);
+    } else {
+      our_shader.use_shader();
+      FrameParams params{
+          glm::vec2(screen_width, screen_height),
+          glm::vec2(default_center_x, default_center_y),
+          glm::vec2(complex_constant_x, complex_constant_y), default_zoom,
+          symmetry};
+      glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameParams), &params);
+
+      glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    }
 
     glfwSwapBuffers(window);
     glfwPollEvents();
@@ -184,6 +242,7 @@ int main() {
   glDeleteVertexArrays(1, &VAO);
   glDeleteBuffers(1, &VBO);
   glDeleteBuffers(1, &EBO);
+  glDeleteBuffers(1, &UBO);
   glfwTerminate();
 
   return 0;
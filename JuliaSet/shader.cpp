@@ -88,4 +88,11 @@ void Shader::set_float(const std::string &name, const float value) const {
 void Shader::set_vec4(const std::string &name, const glm::vec4 vec) const {
   glUniform4f(glGetUniformLocation(program_ID, name.c_str()), vec.x, vec.y,
               vec.z, vec.w);
+}
+
+void Shader::bind_uniform_block(const std::string &name,
+                                const unsigned int binding) const {
+  glUniformBlockBinding(program_ID,
+                        glGetUniformBlockIndex(program_ID, name.c_str()),
+                        binding);
 }
\ No newline at end of file
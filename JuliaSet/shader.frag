@@ -3,11 +3,14 @@
 in vec4 gl_FragCoord;
 out vec4 frag_color;
 
-uniform vec2 screen_dimension;
-uniform vec2 complex_constant;
-uniform vec2 center;
-uniform float zoom;
-uniform int symmetry;
+layout (std140) uniform FrameParams
+{
+    vec2 screen_dimension;
+    vec2 center;
+    vec2 complex_constant;
+    float zoom;
+    int symmetry;
+};
 
 #define MAX_ITERATIONS 100
 
@@ -17,6 +17,8 @@ public:
 
   void set_float(const std::string &name, const float value) const;
   void set_vec4(const std::string &name, const glm::vec4 vec) const;
+  void bind_uniform_block(const std::string &name,
+                          const unsigned int binding) const;
 
 private:
   std::string read_shader_file(const std::string &file_path);
@@ -1,5 +1,9 @@
+#include "frame_params.h"
 #include "shader.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
 
@@ -15,6 +19,13 @@ float t_step = 0.025f;
 float animation_time{0.0f};
 float spiral_param_limit = 30.0 * 3.14159;
 
+// The animation advances in fixed simulation steps, independent of how often
+// frames are presented
+double simulation_step{1.0 / 60.0};
+double max_frame_time{0.25};
+
+const int frames_in_flight{3};
+
 int symmetry{2};
 float default_zoom{2.0f};
 float default_center_x{0.5f};
@@ -36,6 +47,12 @@ void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
   glViewport(0, 0, width, height);
 }
 
+void step_animation() {
+  if (animate)
+    animation_time += t_step;
+  t_step = std::abs(animation_time) > spiral_param_limit ? -t_step : t_step;
+}
+
 void scrollCallback(GLFWwindow *window, double xoffset, double yoffset) {
   if (yoffset == -1) {
     default_zoom *= 1.1f;
@@ -148,47 +165,113 @@ int main() {
 
   glEnable(GL_DEPTH_TEST);
   our_shader.use_shader();
+  our_shader.bind_uniform_block("FrameParams", 0);
+
+  // Ring of per-frame parameter slots. A slot is rewritten only after the
+  // fence of the frame that last read it has signalled, so the CPU never
+  // waits on the frame the GPU is currently drawing.
+  GLint ubo_alignment;
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubo_alignment);
+  GLintptr slot_size = (sizeof(FrameParams) + ubo_alignment - 1) /
+                       ubo_alignment * ubo_alignment;
+
+  unsigned int UBO;
+  glGenBuffers(1, &UBO);
+  glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+
+  char *frame_params_ring = nullptr;
+  if (GLEW_ARB_buffer_storage) {
+    GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_UNIFORM_BUFFER, slot_size * frames_in_flight, nullptr,
+                    flags);
+    frame_params_ring = static_cast<char *>(glMapBufferRange(
+        GL_UNIFORM_BUFFER, 0, slot_size * frames_in_flight, flags));
+  } else {
+    glBufferData(GL_UNIFORM_BUFFER, slot_size * frames_in_flight, nullptr,
+                 GL_DYNAMIC_DRAW);
+  }
 
-  GLint screenDimensions =
-      glGetUniformLocation(our_shader.program_ID, "screen_dimension");
-  GLint fractalCenter = glGetUniformLocation(our_shader.program_ID, "center");
-  GLint fractalZoom = glGetUniformLocation(our_shader.program_ID, "zoom");
-
-  GLint fractalConstant =
-      glGetUniformLocation(our_shader.program_ID, "complex_constant");
-  GLint fractalSymmetry =
-      glGetUniformLocation(our_shader.program_ID, "symmetry");
+  GLsync frame_fences[frames_in_flight] = {};
+  unsigned long frame_index = 0;
 
   glfwSetKeyCallback(window, keyboardCallback);
   glfwSetScrollCallback(window, scrollCallback);
 
-  while (!glfwWindowShouldClose(window)) {
+  double previous_time = glfwGetTime();
+  double accumulator = 0.0;
+  float previous_animation_time = animation_time;
 
-    glClearColor(0.2f, 0.0f, 0.2f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  while (!glfwWindowShouldClose(window)) {
+    double current_time = glfwGetTime();
+    accumulator += std::min(current_time - previous_time, max_frame_time);
+    previous_time = current_time;
+
+    while (accumulator >= simulation_step) {
+      previous_animation_time = animation_time;
+      step_animation();
+      accumulator -= simulation_step;
+    }
 
-    glUniform2f(screenDimensions, screen_width, screen_height);
-    glUniform2f(fractalCenter, default_center_x, default_center_y);
-    glUniform1f(fractalZoom, default_zoom);
+    // Interpolate between the last two simulation steps for smooth pacing
+    float alpha = accumulator / simulation_step;
+    float frame_time = previous_animation_time +
+                       (animation_time - previous_animation_time) * alpha;
+
+    int slot = frame_index % frames_in_flight;
+    if (frame_fences[slot] != nullptr) {
+      while (glClientWaitSync(frame_fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT,
+                              1000000) == GL_TIMEOUT_EXPIRED) {
+      }
+      glDeleteSync(frame_fences[slot]);
+    }
 
     // Choose the complex constant from a parametrized spiral curve
-    float x_t = 0.01 * animation_time * cos(animation_time);
-    float y_t = 0.01 * animation_time * sin(animation_time);
-    glUniform2f(fractalConstant, x_t, y_t);
-    glUniform1i(fractalSymmetry, symmetry);
+    float x_t = 0.01 * frame_time * cos(frame_time);
+    float y_t = 0.01 * frame_time * sin(frame_time);
+    FrameParams params{glm::vec2(screen_width, screen_height),
+                       glm::vec2(default_center_x, default_center_y),
+                       glm::vec2(x_t, y_t), default_zoom, symmetry};
+
+    if (frame_params_ring != nullptr) {
+      std::memcpy(frame_params_ring + slot * slot_size, &params,
+                  sizeof(FrameParams));
+    } else {
+      void *slot_ptr = glMapBufferRange(
+          GL_UNIFORM_BUFFER, slot * slot_size, sizeof(FrameParams),
+          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+              GL_MAP_UNSYNCHRONIZED_BIT);
+      std::memcpy(slot_ptr, &params, sizeof(FrameParams));
+      glUnmapBuffer(GL_UNIFORM_BUFFER);
+    }
+    glBindBufferRange(GL_UNIFORM_BUFFER, 0, UBO, slot * slot_size,
+                      sizeof(FrameParams));
+
+    glClearColor(0.2f, 0.0f, 0.2f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
+    frame_fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ++frame_index;
+
     glfwSwapBuffers(window);
     glfwPollEvents();
-    if (animate)
-      animation_time += t_step;
-    t_step = std::abs(animation_time) > spiral_param_limit ? -t_step : t_step;
+  }
+
+  for (GLsync fence : frame_fences) {
+    if (fence != nullptr) {
+      glDeleteSync(fence);
+    }
+  }
+  if (frame_params_ring != nullptr) {
+    glUnmapBuffer(GL_UNIFORM_BUFFER);
   }
 
   glDeleteVertexArrays(1, &VAO);
   glDeleteBuffers(1, &VBO);
   glDeleteBuffers(1, &EBO);
+  glDeleteBuffers(1, &UBO);
   glfwTerminate();
 
   return 0;
@@ -0,0 +1,290 @@
+#include <algorithm>
+
+#include "buddhabrot.h"
+
+namespace {
+
+// Orbits are sampled from c in [-2, 2] x [-2, 2], which contains the whole
+// Mandelbrot set
+constexpr double kSampleMin = -2.0;
+constexpr double kSampleSize = 4.0;
+constexpr int kGridSize = 256;
+
+// Corners escaping slower than this are treated as close to the boundary
+constexpr int kMinBoundaryIterations = 16;
+
+// Share of samples drawn uniformly from the whole region, so cells outside
+// the focus (e.g. ones crossed by a filament thinner than a cell) are still
+// reached
+constexpr double kUniformFraction = 0.2;
+
+constexpr double kEscapeRadiusSquared = 4.0;
+
+// Main cardioid and period-2 bulb, orbits of these points never escape
+bool in_cardioid_or_bulb(double real, double imag) {
+  double imag_squared = imag * imag;
+  double q = (real - 0.25) * (real - 0.25) + imag_squared;
+  if (q * (q + (real - 0.25)) <= 0.25 * imag_squared) {
+    return true;
+  }
+  return (real + 1.0) * (real + 1.0) + imag_squared <= 0.0625;
+}
+
+int get_iterations(double const_real, double const_imag, int max_iterations) {
+  double real = 0.0;
+  double imag = 0.0;
+  int iterations = 0;
+  while (iterations < max_iterations) {
+    double temp_real = real;
+    real = (real * real - imag * imag) + const_real;
+    imag = (2.0 * temp_real * imag) + const_imag;
+    if (real * real + imag * imag > kEscapeRadiusSquared) {
+      break;
+    }
+    ++iterations;
+  }
+  return iterations;
+}
+
+} // namespace
+
+Buddhabrot::Buddhabrot(int width, int height, int max_iterations,
+                       unsigned int num_threads)
+    : width_(width), height_(height), max_iterations_(max_iterations),
+      num_threads_(std::max(num_threads, 1u)),
+      pixel_size_(3.0 / std::min(width, height)), workers_(num_threads_),
+      histogram_(static_cast<std::size_t>(width) * height, 0.0) {
+  for (unsigned int i = 0; i < num_threads_; ++i) {
+    workers_[i].shard.assign(histogram_.size(), 0.0f);
+    workers_[i].orbit.resize(2 * static_cast<std::size_t>(max_iterations));
+    workers_[i].rng.seed(0x5eed + i);
+  }
+  build_importance_grid();
+
+  threads_.reserve(num_threads_);
+  for (unsigned int i = 0; i < num_threads_; ++i) {
+    threads_.emplace_back([this, i] { worker_loop(i); });
+  }
+}
+
+Buddhabrot::~Buddhabrot() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    phase_ = Phase::Stop;
+    ++generation_;
+  }
+  start_phase_.notify_all();
+  for (std::thread &thread : threads_) {
+    thread.join();
+  }
+}
+
+void Buddhabrot::build_importance_grid() {
+  // Escape counts at the corners of every cell of the coarse grid
+  const int corners = kGridSize + 1;
+  const double cell_size = kSampleSize / kGridSize;
+  std::vector<int> corner_iterations(corners * corners);
+  for (int y = 0; y < corners; ++y) {
+    for (int x = 0; x < corners; ++x) {
+      corner_iterations[y * corners + x] =
+          get_iterations(kSampleMin + x * cell_size,
+                         kSampleMin + y * cell_size, max_iterations_);
+    }
+  }
+
+  // The Buddhabrot focuses on cells that straddle the boundary or whose
+  // corners escape slowly, the Anti-Buddhabrot on every cell touching the
+  // set
+  const int num_cells = kGridSize * kGridSize;
+  boundary_focus_.contains.assign(num_cells, 0);
+  interior_focus_.contains.assign(num_cells, 0);
+  for (int y = 0; y < kGridSize; ++y) {
+    for (int x = 0; x < kGridSize; ++x) {
+      int cell_corners[4] = {corner_iterations[y * corners + x],
+                             corner_iterations[y * corners + x + 1],
+                             corner_iterations[(y + 1) * corners + x],
+                             corner_iterations[(y + 1) * corners + x + 1]};
+      int num_inside = 0;
+      int slowest_escape = 0;
+      for (int iterations : cell_corners) {
+        if (iterations == max_iterations_) {
+          ++num_inside;
+        } else {
+          slowest_escape = std::max(slowest_escape, iterations);
+        }
+      }
+
+      int cell = y * kGridSize + x;
+      if (num_inside > 0) {
+        interior_focus_.cells.push_back(cell);
+        interior_focus_.contains[cell] = 1;
+      }
+      if ((num_inside > 0 && num_inside < 4) ||
+          slowest_escape >= kMinBoundaryIterations) {
+        boundary_focus_.cells.push_back(cell);
+        boundary_focus_.contains[cell] = 1;
+      }
+    }
+  }
+
+  // Sampling density relative to uniform sampling is
+  //   kUniformFraction + (1 - kUniformFraction) * num_cells / focus_cells
+  // inside the focus and kUniformFraction outside, orbits are weighted by
+  // its inverse
+  for (SamplingFocus *focus : {&boundary_focus_, &interior_focus_}) {
+    focus->outside_weight = 1.0 / kUniformFraction;
+    if (!focus->cells.empty()) {
+      focus->focus_weight =
+          1.0 / (kUniformFraction + (1.0 - kUniformFraction) * num_cells /
+                                        focus->cells.size());
+    }
+  }
+}
+
+void Buddhabrot::worker_loop(unsigned int thread_index) {
+  std::uint64_t seen_generation = 0;
+  while (true) {
+    Phase phase;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_phase_.wait(lock,
+                        [&] { return generation_ != seen_generation; });
+      seen_generation = generation_;
+      phase = phase_;
+    }
+
+    if (phase == Phase::Stop) {
+      return;
+    }
+    if (phase == Phase::Sample) {
+      sample(workers_[thread_index], samples_per_thread_);
+    } else {
+      workers_[thread_index].slice_max = reduce(thread_index);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--pending_workers_ == 0) {
+      phase_done_.notify_one();
+    }
+  }
+}
+
+void Buddhabrot::run_phase(Phase phase) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  phase_ = phase;
+  pending_workers_ = num_threads_;
+  ++generation_;
+  start_phase_.notify_all();
+  phase_done_.wait(lock, [this] { return pending_workers_ == 0; });
+}
+
+void Buddhabrot::sample(Worker &worker, std::uint64_t num_samples) {
+  const SamplingFocus &focus =
+      anti_buddhabrot ? interior_focus_ : boundary_focus_;
+
+  const double cell_size = kSampleSize / kGridSize;
+  std::bernoulli_distribution pick_uniform(
+      focus.cells.empty() ? 1.0 : kUniformFraction);
+  std::uniform_int_distribution<std::size_t> pick_cell(
+      0, std::max<std::size_t>(focus.cells.size(), 1) - 1);
+  std::uniform_real_distribution<double> jitter(0.0, cell_size);
+  std::uniform_real_distribution<double> anywhere(kSampleMin,
+                                                  kSampleMin + kSampleSize);
+
+  for (std::uint64_t s = 0; s < num_samples; ++s) {
+    double const_real, const_imag;
+    if (pick_uniform(worker.rng)) {
+      const_real = anywhere(worker.rng);
+      const_imag = anywhere(worker.rng);
+    } else {
+      int cell = focus.cells[pick_cell(worker.rng)];
+      const_real = kSampleMin + (cell % kGridSize) * cell_size +
+                   jitter(worker.rng);
+      const_imag = kSampleMin + (cell / kGridSize) * cell_size +
+                   jitter(worker.rng);
+    }
+
+    // Known interior points can never contribute to the Buddhabrot
+    bool known_inside = in_cardioid_or_bulb(const_real, const_imag);
+    if (known_inside && !anti_buddhabrot) {
+      continue;
+    }
+
+    double real = 0.0;
+    double imag = 0.0;
+    int iterations = 0;
+    while (iterations < max_iterations_) {
+      double temp_real = real;
+      real = (real * real - imag * imag) + const_real;
+      imag = (2.0 * temp_real * imag) + const_imag;
+      if (!known_inside &&
+          real * real + imag * imag > kEscapeRadiusSquared) {
+        break;
+      }
+      worker.orbit[2 * iterations] = real;
+      worker.orbit[2 * iterations + 1] = imag;
+      ++iterations;
+    }
+
+    bool escaped = iterations < max_iterations_;
+    if (escaped == anti_buddhabrot) {
+      continue;
+    }
+
+    int cell_x = std::min(
+        static_cast<int>((const_real - kSampleMin) / cell_size), kGridSize - 1);
+    int cell_y = std::min(
+        static_cast<int>((const_imag - kSampleMin) / cell_size), kGridSize - 1);
+    float weight = static_cast<float>(
+        focus.contains[cell_y * kGridSize + cell_x] ? focus.focus_weight
+                                                    : focus.outside_weight);
+
+    for (int i = 0; i < iterations; ++i) {
+      int x = static_cast<int>((worker.orbit[2 * i] - real_min_) / pixel_size_);
+      int y = static_cast<int>((worker.orbit[2 * i + 1] - imag_min_) /
+                               pixel_size_);
+      if (x >= 0 && x < width_ && y >= 0 && y < height_) {
+        worker.shard[static_cast<std::size_t>(y) * width_ + x] += weight;
+      }
+    }
+  }
+}
+
+double Buddhabrot::reduce(unsigned int thread_index) {
+  // Every thread owns one contiguous slice of pixels across all shards
+  std::size_t begin = histogram_.size() * thread_index / num_threads_;
+  std::size_t end = histogram_.size() * (thread_index + 1) / num_threads_;
+
+  double slice_max = 0.0;
+  for (std::size_t i = begin; i < end; ++i) {
+    double sum = histogram_[i];
+    for (Worker &worker : workers_) {
+      sum += worker.shard[i];
+      worker.shard[i] = 0.0f;
+    }
+    histogram_[i] = sum;
+    slice_max = std::max(slice_max, sum);
+  }
+  return slice_max;
+}
+
+void Buddhabrot::render_pass(std::uint64_t samples_per_thread) {
+  samples_per_thread_ = samples_per_thread;
+  run_phase(Phase::Sample);
+  run_phase(Phase::Reduce);
+
+  max_density_ = 0.0;
+  for (const Worker &worker : workers_) {
+    max_density_ = std::max(max_density_, worker.slice_max);
+  }
+  total_samples_ += samples_per_thread * num_threads_;
+}
+
+void Buddhabrot::reset() {
+  std::fill(histogram_.begin(), histogram_.end(), 0.0);
+  for (Worker &worker : workers_) {
+    std::fill(worker.shard.begin(), worker.shard.end(), 0.0f);
+  }
+  max_density_ = 0.0;
+  total_samples_ = 0;
+}
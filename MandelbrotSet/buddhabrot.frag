@@ -0,0 +1,17 @@
+#version 330 core
+
+in vec4 gl_FragCoord;
+out vec4 frag_color;
+
+uniform vec2 screen_dimension;
+uniform sampler2D density;
+uniform float max_density;
+
+void main()
+{
+    float value = texture(density, gl_FragCoord.xy / screen_dimension).r;
+
+    // Square root keeps the faint orbits visible next to the dense ones
+    float intensity = sqrt(value / max(max_density, 1.0));
+    frag_color = vec4(0.0f, intensity, intensity, 1.0f);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// CPU orbit-density renderer built on the Mandelbrot z^2 + c kernel. Every
+// worker thread accumulates the orbits it samples into its own histogram
+// shard, the shards are then summed into the shared histogram by a parallel
+// reduction so no atomics are needed on the hot path.
+//
+// Constants are importance sampled: most samples come from the cells of a
+// coarse grid near the boundary of the set, the rest uniformly from the
+// whole sampling region. Every orbit is weighted by the inverse of its
+// relative sampling probability, so the histogram converges to the same
+// density as plain uniform sampling, only with less noise.
+class Buddhabrot {
+public:
+  // Record orbits that stay bounded (Anti-Buddhabrot) instead of the ones
+  // that escape (Buddhabrot)
+  bool anti_buddhabrot{false};
+
+  Buddhabrot(int width, int height, int max_iterations,
+             unsigned int num_threads);
+  ~Buddhabrot();
+
+  Buddhabrot(const Buddhabrot &) = delete;
+  Buddhabrot &operator=(const Buddhabrot &) = delete;
+
+  // Samples `samples_per_thread` constants on every thread and merges the
+  // result into the histogram, so the image can be shown after each pass
+  void render_pass(std::uint64_t samples_per_thread);
+  void reset();
+
+  const std::vector<double> &histogram() const { return histogram_; }
+  double max_density() const { return max_density_; }
+  std::uint64_t total_samples() const { return total_samples_; }
+  unsigned int num_threads() const { return num_threads_; }
+
+private:
+  // Aligned to a cache line so the RNG state and results of neighbouring
+  // workers never share one
+  struct alignas(64) Worker {
+    std::vector<float> shard;
+    std::vector<double> orbit;
+    std::mt19937_64 rng;
+    double slice_max{0.0};
+  };
+
+  // Grid cells that most samples are drawn from, with the weights that undo
+  // the bias of drawing from them
+  struct SamplingFocus {
+    std::vector<int> cells;
+    std::vector<char> contains;
+    double focus_weight{1.0};
+    double outside_weight{1.0};
+  };
+
+  enum class Phase { Sample, Reduce, Stop };
+
+  int width_;
+  int height_;
+  int max_iterations_;
+  unsigned int num_threads_;
+
+  // Complex plane region covered by the image
+  double real_min_{-2.0};
+  double imag_min_{-1.5};
+  double pixel_size_;
+
+  std::vector<Worker> workers_;
+  std::vector<double> histogram_;
+  double max_density_{0.0};
+  std::uint64_t total_samples_{0};
+
+  SamplingFocus boundary_focus_;
+  SamplingFocus interior_focus_;
+
+  // Persistent worker pool, woken once per phase of a pass
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_phase_;
+  std::condition_variable phase_done_;
+  Phase phase_{Phase::Sample};
+  std::uint64_t generation_{0};
+  unsigned int pending_workers_{0};
+  std::uint64_t samples_per_thread_{0};
+
+  void build_importance_grid();
+  void worker_loop(unsigned int thread_index);
+  void run_phase(Phase phase);
+  void sample(Worker &worker, std::uint64_t num_samples);
+  double reduce(unsigned int thread_index);
+};
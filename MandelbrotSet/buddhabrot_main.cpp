@@ -0,0 +1,176 @@
+#include "buddhabrot.h"
+#include "shader.h"
+
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+int screen_width{1080};
+int screen_height{1080};
+
+int max_iterations{1000};
+std::uint64_t samples_per_pass{100000};
+
+bool anti_buddhabrot{false};
+bool reset_histogram{false};
+
+std::uint64_t last_samples{0};
+float last_time{0.0f};
+
+float vertices[] = {
+    -1.0f, -1.0f, -0.0f, // 1
+    1.0f,  1.0f,  -0.0f, // 2
+    -1.0f, 1.0f,  -0.0f, // 3
+    1.0f,  -1.0f, -0.0f  // 4
+};
+
+unsigned int indices[] = {
+    0, 1, 2, // 1
+    0, 3, 1  // 2
+};
+
+void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
+  glViewport(0, 0, width, height);
+}
+
+void countSamples(const Buddhabrot &buddhabrot) {
+  double current_time = glfwGetTime();
+  if (current_time - last_time >= 1.0) {
+    std::cout << (buddhabrot.total_samples() - last_samples) / 1.0e6
+              << "M orbits / s, " << buddhabrot.total_samples() / 1.0e6
+              << "M total\n";
+    last_samples = buddhabrot.total_samples();
+    last_time += 1.0;
+  }
+}
+
+void keyboardCallback(GLFWwindow *window, int key, int scancode, int action,
+                      int mods) {
+  if (key == GLFW_KEY_B && action == GLFW_RELEASE) {
+    anti_buddhabrot = !anti_buddhabrot;
+    reset_histogram = true;
+  }
+  if (key == GLFW_KEY_R && action == GLFW_RELEASE) {
+    reset_histogram = true;
+  }
+}
+
+int main() {
+  std::cout << "Use B to switch between the Buddhabrot and Anti-Buddhabrot"
+            << std::endl;
+  std::cout << "Use R to restart the accumulation" << std::endl;
+
+  glfwInit();
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+  GLFWwindow *window = glfwCreateWindow(screen_width, screen_height,
+                                        "Buddhabrot", NULL, NULL);
+
+  if (window == nullptr) {
+    std::cout << "Failed to create GLFW window!\n";
+    glfwTerminate();
+    return -1;
+  }
+
+  glfwMakeContextCurrent(window);
+
+  if (glewInit()) {
+    std::cout << "Failed initializing GLEW\n";
+  }
+
+  glViewport(0, 0, screen_width, screen_height);
+  glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+  unsigned int VAO, VBO, EBO;
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+  glGenBuffers(1, &EBO);
+
+  glBindVertexArray(VAO);
+
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices,
+               GL_STATIC_DRAW);
+
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+  glEnableVertexAttribArray(0);
+
+  glBindVertexArray(VAO);
+
+  unsigned int density_texture;
+  glGenTextures(1, &density_texture);
+  glBindTexture(GL_TEXTURE_2D, density_texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, screen_width, screen_height, 0,
+               GL_RED, GL_FLOAT, nullptr);
+
+  Shader our_shader(
+      std::filesystem::current_path() / "shader.vert",
+      std::filesystem::current_path() / "buddhabrot.frag");
+
+  our_shader.use_shader();
+  GLint screenDimensions =
+      glGetUniformLocation(our_shader.program_ID, "screen_dimension");
+  GLint maxDensity = glGetUniformLocation(our_shader.program_ID, "max_density");
+  glUniform1i(glGetUniformLocation(our_shader.program_ID, "density"), 0);
+
+  glfwSetKeyCallback(window, keyboardCallback);
+
+  Buddhabrot buddhabrot(screen_width, screen_height, max_iterations,
+                        std::thread::hardware_concurrency());
+  std::cout << "Sampling orbits on " << buddhabrot.num_threads()
+            << " threads\n";
+
+  std::vector<float> density(buddhabrot.histogram().size());
+  last_time = glfwGetTime();
+
+  while (!glfwWindowShouldClose(window)) {
+    if (reset_histogram) {
+      buddhabrot.anti_buddhabrot = anti_buddhabrot;
+      buddhabrot.reset();
+      last_samples = 0;
+      reset_histogram = false;
+    }
+
+    // One pass per frame so the image refines while it is being watched
+    buddhabrot.render_pass(samples_per_pass);
+    countSamples(buddhabrot);
+
+    const std::vector<double> &histogram = buddhabrot.histogram();
+    for (std::size_t i = 0; i < histogram.size(); ++i) {
+      density[i] = static_cast<float>(histogram[i]);
+    }
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, screen_width, screen_height,
+                    GL_RED, GL_FLOAT, density.data());
+
+    glClearColor(0.2f, 0.0f, 0.2f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glUniform2f(screenDimensions, screen_width, screen_height);
+    glUniform1f(maxDensity, static_cast<float>(buddhabrot.max_density()));
+
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+
+    glfwSwapBuffers(window);
+    glfwPollEvents();
+  }
+
+  glDeleteTextures(1, &density_texture);
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+  glDeleteBuffers(1, &EBO);
+
+  glfwTerminate();
+  return 0;
+}
@@ -0,0 +1,212 @@
+#include "iteration_buffer.h"
+#include "shader.h"
+#include <iostream>
+#include <filesystem>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+int screen_width{1080};
+int screen_height{1080};
+
+// Must match TILE_SIZE and MAX_ITERATIONS in mandelbrot.comp
+int tile_size{16};
+int max_iterations{500};
+
+bool save_iterations{false};
+
+int num_frames{0};
+float last_time{0.0f};
+
+float zoom = 2.0f;
+float center_x = 0.75f;
+float center_y = 0.5f;
+
+float vertices[] = {
+    -1.0f, -1.0f, -0.0f, // 1
+    1.0f,  1.0f,  -0.0f, // 2
+    -1.0f, 1.0f,  -0.0f, // 3
+    1.0f,  -1.0f, -0.0f  // 4
+};
+
+unsigned int indices[] = {
+    0, 1, 2, // 1
+    0, 3, 1  // 2
+};
+
+void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
+  glViewport(0, 0, width, height);
+}
+
+void countFPS() {
+  double current_time = glfwGetTime();
+  num_frames++;
+  if (current_time - last_time >= 1.0) {
+    std::cout << 1000.0 / num_frames << "ms / frame\n";
+    num_frames = 0;
+    last_time += 1.0;
+  }
+}
+
+void scrollCallback(GLFWwindow *window, double xoffset, double yoffset) {
+  if (yoffset == -1) {
+    zoom *= 1.2f;
+  }
+  if (yoffset == 1) {
+    zoom /= 1.2f;
+  }
+}
+
+void keyboardCallback(GLFWwindow *window, int key, int scancode, int action,
+                      int mods) {
+  if (key == GLFW_KEY_R && action == GLFW_RELEASE) {
+    center_x = 0.75f;
+    center_y = 0.5f;
+    zoom = 2.0f;
+  }
+  if (key == GLFW_KEY_S && action == GLFW_RELEASE) {
+    save_iterations = true;
+  }
+  if (key == GLFW_KEY_UP && action == GLFW_RELEASE) {
+    center_y -= 0.1f;
+  }
+  if (key == GLFW_KEY_DOWN && action == GLFW_RELEASE) {
+    center_y += 0.1f;
+  }
+  if (key == GLFW_KEY_LEFT && action == GLFW_RELEASE) {
+    center_x += 0.1f;
+  }
+  if (key == GLFW_KEY_RIGHT && action == GLFW_RELEASE) {
+    center_x -= 0.1f;
+  }
+}
+
+int main() {
+  std::cout << "Use Arrow keys to control the XY position of the Plot"
+            << std::endl;
+  std::cout << "Use Mouse Scroll Wheel to Zoom In and Out" << std::endl;
+  std::cout << "Use S to save the iteration counts to iterations.mib"
+            << std::endl;
+  std::cout << "Set LIBGL_ALWAYS_SOFTWARE=1 to run on Mesa llvmpipe"
+            << std::endl;
+
+  glfwInit();
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+  GLFWwindow *window = glfwCreateWindow(screen_width, screen_height,
+                                        "Mandelbrot Set - Compute", NULL, NULL);
+
+  if (window == nullptr) {
+    std::cout << "Failed to create GLFW window!\n";
+    glfwTerminate();
+    return -1;
+  }
+
+  glfwMakeContextCurrent(window);
+
+  if (glewInit()) {
+    std::cout << "Failed initializing GLEW\n";
+  }
+
+  if (!GLEW_ARB_shader_group_vote) {
+    std::cout << "ARB_shader_group_vote unavailable, every invocation stops "
+                 "iterating on its own\n";
+  }
+
+  glViewport(0, 0, screen_width, screen_height);
+  glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+  unsigned int VAO, VBO, EBO;
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+  glGenBuffers(1, &EBO);
+
+  glBindVertexArray(VAO);
+
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices,
+               GL_STATIC_DRAW);
+
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+  glEnableVertexAttribArray(0);
+
+  glBindVertexArray(VAO);
+
+  // Iteration counts written by the compute shader, one texel per pixel
+  unsigned int iteration_texture;
+  glGenTextures(1, &iteration_texture);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, iteration_texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32I, screen_width, screen_height);
+  glBindImageTexture(0, iteration_texture, 0, GL_FALSE, 0, GL_WRITE_ONLY,
+                     GL_R32I);
+
+  Shader compute_shader(std::filesystem::current_path() / "mandelbrot.comp");
+  Shader display_shader(
+      std::filesystem::current_path() / "shader.vert",
+      std::filesystem::current_path() / "iterations.frag");
+
+  // Counts are never negative, so the signed texels are read back as is
+  std::vector<std::uint32_t> iterations(
+      static_cast<std::size_t>(screen_width) * screen_height);
+
+  last_time = glfwGetTime();
+
+  compute_shader.use_shader();
+  GLint fractalCenter =
+      glGetUniformLocation(compute_shader.program_ID, "center");
+  GLint fractalZoom = glGetUniformLocation(compute_shader.program_ID, "zoom");
+
+  glfwSetKeyCallback(window, keyboardCallback);
+  glfwSetScrollCallback(window, scrollCallback);
+
+  while (!glfwWindowShouldClose(window)) {
+    glClearColor(0.2f, 0.0f, 0.2f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    countFPS();
+
+    compute_shader.use_shader();
+    glUniform2f(fractalCenter, center_x, center_y);
+    glUniform1f(fractalZoom, zoom);
+
+    glDispatchCompute((screen_width + tile_size - 1) / tile_size,
+                      (screen_height + tile_size - 1) / tile_size, 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    if (save_iterations) {
+      glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+      glGetTexImage(GL_TEXTURE_2D, 0, GL_RED_INTEGER, GL_INT,
+                    iterations.data());
+      if (iteration_buffer::write("iterations.mib", iterations.data(),
+                                  screen_width, screen_height,
+                                  max_iterations)) {
+        std::cout << "Saved iteration counts to iterations.mib\n";
+      }
+      save_iterations = false;
+    }
+
+    display_shader.use_shader();
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+
+    glfwSwapBuffers(window);
+    glfwPollEvents();
+  }
+
+  glDeleteTextures(1, &iteration_texture);
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+  glDeleteBuffers(1, &EBO);
+
+  glfwTerminate();
+  return 0;
+}
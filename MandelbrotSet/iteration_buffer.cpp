@@ -0,0 +1,336 @@
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "iteration_buffer.h"
+
+namespace iteration_buffer {
+
+namespace {
+
+constexpr char kMagic[4] = {'M', 'I', 'B', '1'};
+
+// Largest tile side accepted by the reader, keeps a decoded tile small
+constexpr std::uint32_t kMaxTileSize = 4096;
+
+void put_varint(std::vector<unsigned char> &out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<unsigned char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<unsigned char>(value));
+}
+
+bool get_varint(const unsigned char *&cursor, const unsigned char *end,
+                std::uint64_t &value) {
+  value = 0;
+  for (int shift = 0; cursor < end && shift < 64; shift += 7) {
+    unsigned char byte = *cursor++;
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::uint64_t zigzag(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+  return static_cast<std::int64_t>(value >> 1) ^
+         -static_cast<std::int64_t>(value & 1);
+}
+
+// Escape maps are dominated by long runs of equal counts (the interior of
+// the set, bands of the same escape time), so runs are stored as a length
+// and the difference to the previous run's count
+std::vector<unsigned char>
+encode_run_delta(const std::vector<std::uint32_t> &tile) {
+  std::vector<unsigned char> out;
+  std::int64_t previous = 0;
+  std::size_t i = 0;
+  while (i < tile.size()) {
+    std::size_t run = 1;
+    while (i + run < tile.size() && tile[i + run] == tile[i]) {
+      ++run;
+    }
+    put_varint(out, run);
+    put_varint(out, zigzag(static_cast<std::int64_t>(tile[i]) - previous));
+    previous = tile[i];
+    i += run;
+  }
+  return out;
+}
+
+std::vector<unsigned char> encode_raw(const std::vector<std::uint32_t> &tile,
+                                      TileEncoding encoding) {
+  std::vector<unsigned char> out;
+  if (encoding == TileEncoding::Raw16) {
+    out.resize(tile.size() * sizeof(std::uint16_t));
+    for (std::size_t i = 0; i < tile.size(); ++i) {
+      std::uint16_t value = static_cast<std::uint16_t>(tile[i]);
+      std::memcpy(&out[i * sizeof(value)], &value, sizeof(value));
+    }
+  } else {
+    out.resize(tile.size() * sizeof(std::uint32_t));
+    std::memcpy(out.data(), tile.data(), out.size());
+  }
+  return out;
+}
+
+} // namespace
+
+bool write(const std::string &path, const std::uint32_t *iterations,
+           int width, int height, int max_iterations, int tile_size) {
+  if (width <= 0 || height <= 0 || tile_size <= 0 ||
+      static_cast<std::uint32_t>(tile_size) > kMaxTileSize) {
+    std::cout << "Invalid iteration buffer dimensions\n";
+    return false;
+  }
+
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.width = width;
+  header.height = height;
+  header.tile_size = tile_size;
+  header.max_iterations = max_iterations;
+  header.tiles_x = (width + tile_size - 1) / tile_size;
+  header.tiles_y = (height + tile_size - 1) / tile_size;
+
+  std::ofstream file(path, std::ios::out | std::ios::binary);
+  if (!file) {
+    std::cout << "Failed to open iteration buffer for writing: " << path
+              << "\n";
+    return false;
+  }
+
+  // The index is written as a placeholder first and filled in once every
+  // tile has been streamed out, so encoded tiles are never held in memory
+  std::vector<TileIndexEntry> index(
+      static_cast<std::size_t>(header.tiles_x) * header.tiles_y);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(index.data()),
+             index.size() * sizeof(TileIndexEntry));
+
+  std::uint64_t data_offset =
+      sizeof(Header) + index.size() * sizeof(TileIndexEntry);
+  std::vector<std::uint32_t> tile;
+
+  for (std::uint32_t tile_y = 0; tile_y < header.tiles_y && file; ++tile_y) {
+    for (std::uint32_t tile_x = 0; tile_x < header.tiles_x; ++tile_x) {
+      int x0 = tile_x * tile_size;
+      int y0 = tile_y * tile_size;
+      int tile_width = std::min(tile_size, width - x0);
+      int tile_height = std::min(tile_size, height - y0);
+
+      tile.clear();
+      std::uint32_t largest = 0;
+      for (int y = y0; y < y0 + tile_height; ++y) {
+        const std::uint32_t *row =
+            iterations + static_cast<std::size_t>(y) * width;
+        tile.insert(tile.end(), row + x0, row + x0 + tile_width);
+        largest = std::max(largest, *std::max_element(row + x0,
+                                                      row + x0 + tile_width));
+      }
+
+      TileEncoding encoding = largest <= UINT16_MAX ? TileEncoding::Raw16
+                                                    : TileEncoding::Raw32;
+      std::vector<unsigned char> encoded = encode_raw(tile, encoding);
+      std::vector<unsigned char> runs = encode_run_delta(tile);
+      if (runs.size() < encoded.size()) {
+        encoding = TileEncoding::RunDelta;
+        encoded = std::move(runs);
+      }
+
+      TileIndexEntry &entry = index[tile_y * header.tiles_x + tile_x];
+      entry.offset = data_offset;
+      entry.size = encoded.size();
+      entry.encoding = encoding;
+      file.write(reinterpret_cast<const char *>(encoded.data()),
+                 encoded.size());
+      data_offset += encoded.size();
+    }
+  }
+
+  file.seekp(sizeof(Header));
+  file.write(reinterpret_cast<const char *>(index.data()),
+             index.size() * sizeof(TileIndexEntry));
+
+  if (!file) {
+    std::cout << "Failed to write iteration buffer: " << path << "\n";
+    return false;
+  }
+  return true;
+}
+
+Reader::Reader(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::cout << "Failed to open iteration buffer: " << path << "\n";
+    return;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<std::size_t>(file_stat.st_size) < sizeof(Header)) {
+    std::cout << "Invalid iteration buffer: " << path << "\n";
+    close(fd);
+    return;
+  }
+
+  std::size_t size = file_stat.st_size;
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    std::cout << "Failed to map iteration buffer: " << path << "\n";
+    return;
+  }
+
+  const unsigned char *data = static_cast<const unsigned char *>(mapping);
+  std::memcpy(&header_, data, sizeof(Header));
+
+  // Dimensions are read back through int accessors, so they must fit in an
+  // int before any tile arithmetic is done with them
+  bool valid = std::memcmp(header_.magic, kMagic, sizeof(kMagic)) == 0 &&
+               header_.width > 0 && header_.width <= INT_MAX &&
+               header_.height > 0 && header_.height <= INT_MAX &&
+               header_.tile_size > 0 && header_.tile_size <= kMaxTileSize &&
+               header_.max_iterations <= INT_MAX;
+  if (valid) {
+    std::uint64_t tile_size = header_.tile_size;
+    valid = header_.tiles_x == (header_.width + tile_size - 1) / tile_size &&
+            header_.tiles_y == (header_.height + tile_size - 1) / tile_size &&
+            (size - sizeof(Header)) / sizeof(TileIndexEntry) /
+                    header_.tiles_x >=
+                header_.tiles_y;
+  }
+  if (!valid) {
+    std::cout << "Invalid iteration buffer: " << path << "\n";
+    munmap(mapping, size);
+    return;
+  }
+
+  data_ = data;
+  size_ = size;
+  index_ = reinterpret_cast<const TileIndexEntry *>(data + sizeof(Header));
+}
+
+Reader::~Reader() {
+  if (data_ != nullptr) {
+    munmap(const_cast<unsigned char *>(data_), size_);
+    data_ = nullptr;
+  }
+}
+
+bool Reader::read_tile(int tile_x, int tile_y,
+                       std::vector<std::uint32_t> &tile) const {
+  if (!is_open() || tile_x < 0 || tile_y < 0 ||
+      tile_x >= static_cast<int>(header_.tiles_x) ||
+      tile_y >= static_cast<int>(header_.tiles_y)) {
+    return false;
+  }
+
+  const TileIndexEntry &entry = index_[tile_y * header_.tiles_x + tile_x];
+  if (entry.offset > size_ || entry.size > size_ - entry.offset) {
+    std::cout << "Corrupt iteration buffer tile (" << tile_x << ", " << tile_y
+              << ")\n";
+    return false;
+  }
+
+  int tile_width = std::min(tile_size(), width() - tile_x * tile_size());
+  int tile_height = std::min(tile_size(), height() - tile_y * tile_size());
+  std::size_t count = static_cast<std::size_t>(tile_width) * tile_height;
+  tile.resize(count);
+
+  const unsigned char *cursor = data_ + entry.offset;
+  const unsigned char *end = cursor + entry.size;
+
+  switch (entry.encoding) {
+  case TileEncoding::Raw16:
+    if (entry.size != count * sizeof(std::uint16_t)) {
+      return false;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      std::uint16_t value;
+      std::memcpy(&value, cursor + i * sizeof(value), sizeof(value));
+      tile[i] = value;
+    }
+    return true;
+
+  case TileEncoding::Raw32:
+    if (entry.size != count * sizeof(std::uint32_t)) {
+      return false;
+    }
+    std::memcpy(tile.data(), cursor, entry.size);
+    return true;
+
+  case TileEncoding::RunDelta: {
+    std::int64_t previous = 0;
+    std::size_t i = 0;
+    while (i < count) {
+      std::uint64_t run, delta;
+      if (!get_varint(cursor, end, run) || !get_varint(cursor, end, delta) ||
+          run > count - i) {
+        return false;
+      }
+      previous += unzigzag(delta);
+      std::fill_n(tile.begin() + i, run, static_cast<std::uint32_t>(previous));
+      i += run;
+    }
+    return true;
+  }
+  }
+  return false;
+}
+
+bool Reader::read_region(int x, int y, int width, int height,
+                         std::vector<std::uint32_t> &region) const {
+  if (!is_open() || x < 0 || y < 0 || width <= 0 || height <= 0 ||
+      x + width > this->width() || y + height > this->height()) {
+    return false;
+  }
+
+  region.resize(static_cast<std::size_t>(width) * height);
+  std::vector<std::uint32_t> tile;
+
+  for (int tile_y = y / tile_size(); tile_y * tile_size() < y + height;
+       ++tile_y) {
+    for (int tile_x = x / tile_size(); tile_x * tile_size() < x + width;
+         ++tile_x) {
+      if (!read_tile(tile_x, tile_y, tile)) {
+        return false;
+      }
+
+      int tile_x0 = tile_x * tile_size();
+      int tile_y0 = tile_y * tile_size();
+      int tile_width = std::min(tile_size(), this->width() - tile_x0);
+
+      int copy_x0 = std::max(x, tile_x0);
+      int copy_x1 = std::min(x + width, tile_x0 + tile_width);
+      int copy_y0 = std::max(y, tile_y0);
+      int copy_y1 = std::min(y + height, tile_y0 + tile_size());
+
+      for (int row = copy_y0; row < copy_y1; ++row) {
+        std::copy(tile.begin() + (row - tile_y0) * tile_width +
+                      (copy_x0 - tile_x0),
+                  tile.begin() + (row - tile_y0) * tile_width +
+                      (copy_x1 - tile_x0),
+                  region.begin() + static_cast<std::size_t>(row - y) * width +
+                      (copy_x0 - x));
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace iteration_buffer
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compact on-disk format for the escape-time counts of get_iterations().
+//
+// The image is split into square tiles that are encoded independently: as
+// 16-bit counts when they fit, as 32-bit counts otherwise, or as runs of
+// equal counts with the run values delta coded, whichever is smallest. A
+// tile index after the header gives the offset of every tile, so readers
+// can decode any region without touching the rest of the file.
+namespace iteration_buffer {
+
+enum class TileEncoding : std::uint32_t { Raw16 = 0, Raw32 = 1, RunDelta = 2 };
+
+struct Header {
+  char magic[4];
+  std::uint32_t width;
+  std::uint32_t height;
+  std::uint32_t tile_size;
+  std::uint32_t max_iterations;
+  std::uint32_t tiles_x;
+  std::uint32_t tiles_y;
+  std::uint32_t reserved;
+};
+
+struct TileIndexEntry {
+  std::uint64_t offset;
+  std::uint32_t size;
+  TileEncoding encoding;
+};
+
+// Writes `iterations`, row-major with `width` counts per row, to `path`
+bool write(const std::string &path, const std::uint32_t *iterations,
+           int width, int height, int max_iterations, int tile_size = 64);
+
+// Memory maps a buffer written by write(). Tiles are decoded on demand, so
+// only the pages of the requested tiles are ever read from disk.
+class Reader {
+public:
+  explicit Reader(const std::string &path);
+  ~Reader();
+
+  Reader(const Reader &) = delete;
+  Reader &operator=(const Reader &) = delete;
+
+  bool is_open() const { return data_ != nullptr; }
+
+  int width() const { return header_.width; }
+  int height() const { return header_.height; }
+  int tile_size() const { return header_.tile_size; }
+  int max_iterations() const { return header_.max_iterations; }
+
+  // Decodes one tile, row-major with the width of that tile (edge tiles are
+  // smaller than tile_size)
+  bool read_tile(int tile_x, int tile_y,
+                 std::vector<std::uint32_t> &tile) const;
+
+  // Decodes the `width` x `height` region starting at (x, y), touching only
+  // the tiles that overlap it
+  bool read_region(int x, int y, int width, int height,
+                   std::vector<std::uint32_t> &region) const;
+
+private:
+  const unsigned char *data_{nullptr};
+  std::size_t size_{0};
+  Header header_{};
+  const TileIndexEntry *index_{nullptr};
+};
+
+} // namespace iteration_buffer
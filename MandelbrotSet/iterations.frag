@@ -0,0 +1,24 @@
+#version 430 core
+
+in vec4 gl_FragCoord;
+out vec4 frag_color;
+
+layout (binding = 0) uniform isampler2D iteration_image;
+
+#define MAX_ITERATIONS 500
+
+vec4 return_color()
+{
+    int iter = texelFetch(iteration_image, ivec2(gl_FragCoord.xy), 0).r;
+    if (iter == MAX_ITERATIONS)
+    {
+        return vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    float iterations = float(iter) / MAX_ITERATIONS * 5.0;
+    return vec4(0.0f, iterations, iterations, 1.0f);
+}
+
+void main()
+{
+    frag_color = return_color();
+}
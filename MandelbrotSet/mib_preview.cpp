@@ -0,0 +1,132 @@
+#include "iteration_buffer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Downsamples and recolours an iteration buffer written by mandelbrot_compute
+// into a PPM image. The source is decoded one band of tiles at a time through
+// read_region, so only the tiles under the requested region are touched and
+// memory use does not grow with the size of the buffer.
+
+void usage() {
+  std::cout << "Usage: mib_preview <input.mib> <output.ppm> [factor] "
+               "[x y width height]\n";
+}
+
+// Same ramp as iterations.frag
+void color(double iterations, int max_iterations, unsigned char *rgb) {
+  if (iterations >= max_iterations) {
+    rgb[0] = rgb[1] = rgb[2] = 0;
+    return;
+  }
+  double value = std::min(iterations / max_iterations * 5.0, 1.0);
+  rgb[0] = 0;
+  rgb[1] = rgb[2] = static_cast<unsigned char>(value * 255.0);
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3 && argc != 4 && argc != 8) {
+    usage();
+    return -1;
+  }
+
+  iteration_buffer::Reader reader(argv[1]);
+  if (!reader.is_open()) {
+    return -1;
+  }
+
+  int factor = argc > 3 ? std::atoi(argv[3]) : 1;
+  int x = 0;
+  int y = 0;
+  int width = reader.width();
+  int height = reader.height();
+  if (argc == 8) {
+    x = std::atoi(argv[4]);
+    y = std::atoi(argv[5]);
+    width = std::atoi(argv[6]);
+    height = std::atoi(argv[7]);
+  }
+
+  if (factor <= 0 || x < 0 || y < 0 || width <= 0 || height <= 0 ||
+      width > reader.width() - x || height > reader.height() - y ||
+      width < factor || height < factor) {
+    std::cout << "Region or factor outside of the " << reader.width() << "x"
+              << reader.height() << " iteration buffer\n";
+    return -1;
+  }
+
+  // Partial blocks at the right and top edges are dropped
+  int output_width = width / factor;
+  int output_height = height / factor;
+  std::vector<unsigned char> image(
+      static_cast<std::size_t>(output_width) * output_height * 3);
+
+  // Every band ends on a tile-row boundary, so each tile is decoded exactly
+  // once. Source rows of a block that straddles two tile rows are carried
+  // over in `pending` until the next band completes the block.
+  int source_width = output_width * factor;
+  long long source_end = y + static_cast<long long>(output_height) * factor;
+  std::vector<std::uint32_t> band;
+  std::vector<std::uint32_t> pending;
+
+  long long next_source_row = y;
+  int row = 0;
+  while (next_source_row < source_end) {
+    long long band_end =
+        std::min((next_source_row / reader.tile_size() + 1) *
+                     reader.tile_size(),
+                 source_end);
+    if (!reader.read_region(x, static_cast<int>(next_source_row),
+                            source_width,
+                            static_cast<int>(band_end - next_source_row),
+                            band)) {
+      std::cout << "Failed to decode iteration buffer: " << argv[1] << "\n";
+      return -1;
+    }
+    pending.insert(pending.end(), band.begin(), band.end());
+    next_source_row = band_end;
+
+    int rows = static_cast<int>(pending.size() / source_width / factor);
+    for (int block_y = 0; block_y < rows; ++block_y) {
+      for (int block_x = 0; block_x < output_width; ++block_x) {
+        double sum = 0.0;
+        for (int j = 0; j < factor; ++j) {
+          for (int i = 0; i < factor; ++i) {
+            sum += pending[static_cast<std::size_t>(block_y * factor + j) *
+                               source_width +
+                           block_x * factor + i];
+          }
+        }
+
+        // Iteration rows start at the bottom of the window, PPM rows at the
+        // top
+        int output_row = output_height - 1 - (row + block_y);
+        color(sum / (factor * factor), reader.max_iterations(),
+              &image[(static_cast<std::size_t>(output_row) * output_width +
+                      block_x) *
+                     3]);
+      }
+    }
+
+    pending.erase(pending.begin(),
+                  pending.begin() + static_cast<std::size_t>(rows) * factor *
+                                        source_width);
+    row += rows;
+  }
+
+  std::ofstream file(argv[2], std::ios::out | std::ios::binary);
+  file << "P6\n" << output_width << " " << output_height << "\n255\n";
+  file.write(reinterpret_cast<const char *>(image.data()), image.size());
+  if (!file) {
+    std::cout << "Failed to write image: " << argv[2] << "\n";
+    return -1;
+  }
+
+  std::cout << "Wrote " << output_width << "x" << output_height
+            << " preview to " << argv[2] << "\n";
+  return 0;
+}
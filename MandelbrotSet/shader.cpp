@@ -61,6 +61,18 @@ Shader::Shader(const std::string &vertex_shader_path,
   add_shader(program_ID, vertex_shader_path, GL_VERTEX_SHADER);
   add_shader(program_ID, frag_shader_path, GL_FRAGMENT_SHADER);
 
+  link_program();
+}
+
+Shader::Shader(const std::string &compute_shader_path) {
+  program_ID = glCreateProgram();
+
+  add_shader(program_ID, compute_shader_path, GL_COMPUTE_SHADER);
+
+  link_program();
+}
+
+void Shader::link_program() {
   glLinkProgram(program_ID);
 
   int success;
@@ -11,6 +11,7 @@ public:
   unsigned int program_ID;
   Shader(const std::string &vertex_shader_path,
          const std::string &frag_shader_path);
+  explicit Shader(const std::string &compute_shader_path);
   ~Shader();
 
   void use_shader() const;
@@ -22,4 +23,5 @@ private:
   std::string read_shader_file(const std::string &file_path);
   void add_shader(unsigned int program, const std::string &shader_path,
                   GLenum shader_type);
+  void link_program();
 };
\ No newline at end of file